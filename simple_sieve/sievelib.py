@@ -0,0 +1,194 @@
+"""Python bindings for the sieve library.
+
+Loads SIEVELIB.C, built as a shared library as described in README.md, through ctypes.
+Results are handed out as memoryviews over memory the library filled in, either its own
+or a buffer allocated here, so nothing is copied or converted on the way out.
+numpy.frombuffer() turns any of them into an array without a copy either.
+
+ctypes releases the GIL for the duration of each call into the library, so other
+Python threads keep running while a range is being sieved.
+
+    from sievelib import PrimeSieve, spf_table
+
+    with PrimeSieve(0, 10 ** 8) as sieve:
+        primes = sieve.primes()         # memoryview of C longs
+        bitmap = sieve.bitmap()         # memoryview of bytes, bit set if composite
+
+The shared library is looked for in the SIEVELIB environment variable, and otherwise
+next to this file.
+"""
+
+import ctypes
+import os
+import sys
+
+_NAMES = {"win32": "sievelib.dll", "darwin": "libsieve.dylib"}
+
+
+def _load():
+    path = os.environ.get("SIEVELIB")
+    if path is None:
+        path = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                            _NAMES.get(sys.platform, "libsieve.so"))
+
+    lib = ctypes.CDLL(path)
+
+    lib.sieve_version.restype = ctypes.c_long
+    lib.sieve_version.argtypes = []
+    lib.sieve_create.restype = ctypes.c_void_p
+    lib.sieve_create.argtypes = [ctypes.c_long, ctypes.c_long]
+    lib.sieve_range.restype = ctypes.c_int
+    lib.sieve_range.argtypes = [ctypes.c_void_p]
+    lib.sieve_count.restype = ctypes.c_long
+    lib.sieve_count.argtypes = [ctypes.c_void_p]
+    lib.sieve_next.restype = ctypes.c_long
+    lib.sieve_next.argtypes = [ctypes.c_void_p, ctypes.c_long]
+    lib.sieve_destroy.restype = None
+    lib.sieve_destroy.argtypes = [ctypes.c_void_p]
+    lib.sieve_bitmap.restype = ctypes.c_void_p
+    lib.sieve_bitmap.argtypes = [ctypes.c_void_p]
+    lib.sieve_bitmap_bytes.restype = ctypes.c_long
+    lib.sieve_bitmap_bytes.argtypes = [ctypes.c_void_p]
+    lib.sieve_first.restype = ctypes.c_long
+    lib.sieve_first.argtypes = [ctypes.c_void_p]
+    lib.sieve_fill.restype = ctypes.c_long
+    lib.sieve_fill.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_long), ctypes.c_long]
+    lib.sieve_spf.restype = ctypes.c_void_p
+    lib.sieve_spf.argtypes = [ctypes.c_long]
+    lib.sieve_free_spf.restype = None
+    lib.sieve_free_spf.argtypes = [ctypes.c_void_p]
+
+    if lib.sieve_version() < 2:
+        raise ImportError("%s is too old for these bindings" % path)
+
+    return lib
+
+
+_lib = _load()
+
+
+def _native(array, code):
+    """View a ctypes array with a plain struct format code, which memoryview indexing
+    and numpy both understand, rather than the explicit-endian one ctypes reports."""
+    return memoryview(array).cast("B").cast(code)
+
+
+def _view(ctype, code, address, count, owner):
+    """Wrap memory owned by the library in a memoryview that keeps its owner alive."""
+    array = (ctype * count).from_address(address)
+    array._owner = owner
+    return _native(array, code)
+
+
+class _SieveOwner(object):
+    """Destroys a sieve once neither its PrimeSieve nor any view of its bitmap is left."""
+
+    def __init__(self, handle):
+        self.handle = handle
+
+    def __del__(self):
+        _lib.sieve_destroy(self.handle)
+
+
+class PrimeSieve(object):
+    """The primes in a range [low, high]. The range is sieved on creation unless
+    sieve=False is passed, in which case sieve() does it later."""
+
+    def __init__(self, low, high, sieve=True):
+        self._handle = _lib.sieve_create(low, high)
+        if not self._handle:
+            raise MemoryError("can't create a sieve for %d to %d" % (low, high))
+
+        self._owner = _SieveOwner(self._handle)
+
+        self.low = low
+        self.high = high
+
+        if sieve:
+            self.sieve()
+
+    def sieve(self):
+        """Sieve the range. The GIL is released while the library does so."""
+        if not _lib.sieve_range(self._check()):
+            raise MemoryError("out of memory sieving %d to %d" % (self.low, self.high))
+        return self
+
+    def count(self):
+        """The number of primes in the range."""
+        return _lib.sieve_count(self._sieved())
+
+    def __len__(self):
+        return self.count()
+
+    def next(self, after):
+        """The smallest prime in the range above after, or None."""
+        prime = _lib.sieve_next(self._sieved(), after)
+        return None if prime < 0 else prime
+
+    def bitmap(self):
+        """The sieve's own bitmap, without a copy. Bit k, counting from the least
+        significant bit of each byte, is clear if first() + 2k is prime. The view stays
+        valid after close(), which then leaves the bitmap to be freed with the last view."""
+        handle = self._sieved()
+        return _view(ctypes.c_ubyte, "B", _lib.sieve_bitmap(handle), _lib.sieve_bitmap_bytes(handle), self._owner)
+
+    def first(self):
+        """The odd number that bit 0 of the bitmap stands for."""
+        return _lib.sieve_first(self._check())
+
+    def primes(self):
+        """The primes in the range as C longs, written by the library straight into a
+        buffer allocated here."""
+        handle = self._sieved()
+        count = _lib.sieve_count(handle)
+        buffer = (ctypes.c_long * max(count, 1))()
+        _lib.sieve_fill(handle, buffer, count)
+        return _native(buffer, "l")[:count]
+
+    def __iter__(self):
+        return iter(self.primes())
+
+    def close(self):
+        """Release the sieve. It is destroyed right away unless views from bitmap() are
+        still around, in which case the last of them takes it along."""
+        self._handle = None
+        self._owner = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc_info):
+        self.close()
+
+    def _check(self):
+        if not self._handle:
+            raise ValueError("the sieve has been closed")
+        return self._handle
+
+    def _sieved(self):
+        handle = self._check()
+        if _lib.sieve_count(handle) < 0:
+            raise ValueError("the range hasn't been sieved yet")
+        return handle
+
+
+class _SpfOwner(object):
+    """Frees a smallest prime factor table once no view of it is left."""
+
+    def __init__(self, address):
+        self.address = address
+
+    def __del__(self):
+        _lib.sieve_free_spf(self.address)
+
+
+def spf_table(limit):
+    """A smallest prime factor table for the odd numbers up to limit, as unsigned
+    shorts: entry n // 2 is the smallest prime factor of odd n, or 0 if n is 1 or prime.
+    limit must be below 2 ** 32. The table stays in the library's memory and is freed
+    with the last view of it."""
+    address = _lib.sieve_spf(limit)
+    if not address:
+        raise MemoryError("can't build a smallest prime factor table up to %d" % limit)
+
+    return _view(ctypes.c_ushort, "H", address, limit // 2 + 1, _SpfOwner(address))